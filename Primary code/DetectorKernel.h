@@ -0,0 +1,51 @@
+#ifndef DETECTOR_KERNEL_H
+#define DETECTOR_KERNEL_H
+
+// 看门狗检测逻辑的核心更新，不依赖 ns-3，WatchdogNode 与离线微基准共用
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum NodeStatus {
+    NO_STATUS,
+    POSITIVE_STATUS,
+    NEGATIVE_STATUS
+};
+
+// 每种观察对信誉的增量，按 NodeStatus 索引
+static const double g_reputationDelta[3] = { 0.0, 1.0, -1.0 };
+
+inline NodeStatus ReputationVerdict(double reputation, double threshold)
+{
+    if (reputation >= threshold)
+    {
+        return POSITIVE_STATUS;
+    }
+    if (reputation < -threshold)
+    {
+        return NEGATIVE_STATUS;
+    }
+    return NO_STATUS;
+}
+
+// 单个观察：正面 +1，负面 -1，无信息不变，返回更新后的判定
+inline NodeStatus UpdateReputation(double &reputation, NodeStatus event, double threshold)
+{
+    reputation += g_reputationDelta[event];
+    return ReputationVerdict(reputation, threshold);
+}
+
+// 批量更新：观察以 (看门狗编号, 事件) 两个数组给出，信誉和判定按看门狗编号存放在各自的数组中
+inline void UpdateReputationBatch(const uint32_t *watchdogs, const uint8_t *events, size_t n,
+                                  double *reputation, uint8_t *verdicts, double threshold)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t w = watchdogs[i];
+        double r = reputation[w] + g_reputationDelta[events[i]];
+        reputation[w] = r;
+        verdicts[w] = (uint8_t)(r >= threshold ? POSITIVE_STATUS : (r < -threshold ? NEGATIVE_STATUS : NO_STATUS));
+    }
+}
+
+#endif // DETECTOR_KERNEL_H
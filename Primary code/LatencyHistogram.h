@@ -0,0 +1,190 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+// 对数分桶的时延直方图（HdrHistogram 的布局），不依赖 ns-3：
+// 取值为纳秒，小于 64 ns 时每个桶宽 1 ns，之后每个 2 的幂区间分 32 个子桶，相对误差不超过 1/32；
+// 上限约 275 秒，超出的计入最后一个桶。内存固定，与样本数无关，各桶计数直接相加即可合并
+
+#include <stdint.h>
+#include <cmath>
+#include <cstring>
+
+class LatencyHistogram {
+public:
+    static const uint32_t SUB_BUCKET_BITS = 6;
+    static const uint32_t MAX_EXPONENT = 37;
+    static const uint32_t BUCKETS = (1u << SUB_BUCKET_BITS) + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * (1u << (SUB_BUCKET_BITS - 1));
+
+    LatencyHistogram();
+
+    void Record(uint64_t ns);
+    void Merge(const LatencyHistogram &other);
+    // 由桶计数重建（例如从结果文件读入），最小值、最大值和均值按桶边界近似
+    void Load(const uint64_t *counts);
+    uint64_t Count() const;
+    uint64_t Min() const;
+    uint64_t Max() const;
+    double Mean() const;
+    // 第 p 百分位（0-100）所在桶的上界，不超过观测到的最大值
+    uint64_t Percentile(double p) const;
+    const uint64_t *Counts() const;
+
+    static uint32_t Index(uint64_t ns);
+    static uint64_t LowerBound(uint32_t index);
+    static uint64_t UpperBound(uint32_t index);
+
+private:
+    uint64_t m_counts[BUCKETS];
+    uint64_t m_count;
+    uint64_t m_min;
+    uint64_t m_max;
+    double m_sum;
+};
+
+inline LatencyHistogram::LatencyHistogram()
+    : m_count(0),
+      m_min(UINT64_MAX),
+      m_max(0),
+      m_sum(0.0)
+{
+    memset(m_counts, 0, sizeof(m_counts));
+}
+
+inline uint32_t LatencyHistogram::Index(uint64_t ns)
+{
+    const uint64_t limit = (2ull << MAX_EXPONENT) - 1;
+    if (ns > limit)
+    {
+        ns = limit;
+    }
+    if (ns < (1u << SUB_BUCKET_BITS))
+    {
+        return (uint32_t)ns;
+    }
+    uint32_t exponent = 63 - __builtin_clzll(ns);
+    uint32_t shift = exponent - (SUB_BUCKET_BITS - 1);
+    uint32_t half = 1u << (SUB_BUCKET_BITS - 1);
+    return (1u << SUB_BUCKET_BITS) + (exponent - SUB_BUCKET_BITS) * half + (uint32_t)(ns >> shift) - half;
+}
+
+inline uint64_t LatencyHistogram::LowerBound(uint32_t index)
+{
+    if (index < (1u << SUB_BUCKET_BITS))
+    {
+        return index;
+    }
+    uint32_t half = 1u << (SUB_BUCKET_BITS - 1);
+    uint32_t octave = (index - (1u << SUB_BUCKET_BITS)) / half;
+    uint64_t sub = (index - (1u << SUB_BUCKET_BITS)) % half + half;
+    return sub << (octave + 1);
+}
+
+inline uint64_t LatencyHistogram::UpperBound(uint32_t index)
+{
+    return index + 1 < BUCKETS ? LowerBound(index + 1) - 1 : (2ull << MAX_EXPONENT) - 1;
+}
+
+inline void LatencyHistogram::Record(uint64_t ns)
+{
+    m_counts[Index(ns)]++;
+    m_count++;
+    m_sum += ns;
+    if (ns < m_min)
+    {
+        m_min = ns;
+    }
+    if (ns > m_max)
+    {
+        m_max = ns;
+    }
+}
+
+inline void LatencyHistogram::Merge(const LatencyHistogram &other)
+{
+    for (uint32_t i = 0; i < BUCKETS; ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    if (other.m_min < m_min)
+    {
+        m_min = other.m_min;
+    }
+    if (other.m_max > m_max)
+    {
+        m_max = other.m_max;
+    }
+}
+
+inline void LatencyHistogram::Load(const uint64_t *counts)
+{
+    LatencyHistogram loaded;
+    for (uint32_t i = 0; i < BUCKETS; ++i)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+        loaded.m_counts[i] = counts[i];
+        loaded.m_count += counts[i];
+        loaded.m_sum += counts[i] * 0.5 * ((double)LowerBound(i) + (double)UpperBound(i));
+        if (loaded.m_min == UINT64_MAX)
+        {
+            loaded.m_min = LowerBound(i);
+        }
+        loaded.m_max = UpperBound(i);
+    }
+    Merge(loaded);
+}
+
+inline uint64_t LatencyHistogram::Count() const
+{
+    return m_count;
+}
+
+inline uint64_t LatencyHistogram::Min() const
+{
+    return m_count > 0 ? m_min : 0;
+}
+
+inline uint64_t LatencyHistogram::Max() const
+{
+    return m_max;
+}
+
+inline double LatencyHistogram::Mean() const
+{
+    return m_count > 0 ? m_sum / m_count : 0.0;
+}
+
+inline uint64_t LatencyHistogram::Percentile(double p) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    uint64_t target = (uint64_t)std::ceil(p / 100.0 * m_count);
+    if (target == 0)
+    {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= target)
+        {
+            uint64_t upper = UpperBound(i);
+            return upper < m_max ? upper : m_max;
+        }
+    }
+    return m_max;
+}
+
+inline const uint64_t *LatencyHistogram::Counts() const
+{
+    return m_counts;
+}
+
+#endif // LATENCY_HISTOGRAM_H
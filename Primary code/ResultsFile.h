@@ -0,0 +1,335 @@
+#ifndef RESULTS_FILE_H
+#define RESULTS_FILE_H
+
+// 单次运行结果的列式二进制文件，不依赖 ns-3：
+//   文件头 | 各列数据（按 8 字节对齐）| 列索引
+// 读取端 mmap 整个文件后按索引中的偏移直接访问各列，不做解析和拷贝。
+// 列名形如 "表.列"，同一表的各列行数相同；run.* 与 config.* 每列只有一行
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+enum ResultsColumnType {
+    RESULTS_F64,
+    RESULTS_U64,
+    RESULTS_U32,
+    RESULTS_U8
+};
+
+static const char g_resultsMagic[8] = { 'G', 'H', 'R', 'E', 'S', 'U', 'L', 'T' };
+static const uint32_t RESULTS_VERSION = 1;
+static const uint32_t RESULTS_BYTE_ORDER = 0x01020304; // 读取端据此识别写入端的字节序
+
+struct ResultsFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t columnCount;
+    uint32_t reserved;
+    uint64_t indexOffset;
+    uint64_t fileSize;
+};
+
+struct ResultsColumnEntry {
+    char name[40]; // 以 NUL 结尾
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t count;
+};
+
+inline uint32_t ResultsTypeSize(uint32_t type)
+{
+    switch (type)
+    {
+    case RESULTS_F64:
+    case RESULTS_U64:
+        return 8;
+    case RESULTS_U32:
+        return 4;
+    case RESULTS_U8:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+class ResultsFileWriter {
+public:
+    void AddColumn(const std::string &name, ResultsColumnType type, const void *data, uint64_t count);
+    void AddColumn(const std::string &name, const std::vector<double> &values);
+    void AddColumn(const std::string &name, const std::vector<uint64_t> &values);
+    void AddColumn(const std::string &name, const std::vector<uint32_t> &values);
+    void AddColumn(const std::string &name, const std::vector<uint8_t> &values);
+    void AddScalar(const std::string &name, double value);
+    void AddScalar(const std::string &name, uint64_t value);
+
+    // 先写临时文件再改名，读取端不会看到写了一半的文件
+    bool Write(const std::string &path) const;
+
+private:
+    struct Column {
+        std::string name;
+        uint32_t type;
+        uint64_t count;
+        std::vector<char> bytes;
+    };
+
+    std::vector<Column> m_columns;
+};
+
+inline void ResultsFileWriter::AddColumn(const std::string &name, ResultsColumnType type, const void *data, uint64_t count)
+{
+    Column column;
+    column.name = name.substr(0, sizeof(((ResultsColumnEntry *)0)->name) - 1);
+    column.type = type;
+    column.count = count;
+    const char *bytes = (const char *)data;
+    column.bytes.assign(bytes, bytes + count * ResultsTypeSize(type));
+    m_columns.push_back(column);
+}
+
+inline void ResultsFileWriter::AddColumn(const std::string &name, const std::vector<double> &values)
+{
+    AddColumn(name, RESULTS_F64, values.empty() ? 0 : &values[0], values.size());
+}
+
+inline void ResultsFileWriter::AddColumn(const std::string &name, const std::vector<uint64_t> &values)
+{
+    AddColumn(name, RESULTS_U64, values.empty() ? 0 : &values[0], values.size());
+}
+
+inline void ResultsFileWriter::AddColumn(const std::string &name, const std::vector<uint32_t> &values)
+{
+    AddColumn(name, RESULTS_U32, values.empty() ? 0 : &values[0], values.size());
+}
+
+inline void ResultsFileWriter::AddColumn(const std::string &name, const std::vector<uint8_t> &values)
+{
+    AddColumn(name, RESULTS_U8, values.empty() ? 0 : &values[0], values.size());
+}
+
+inline void ResultsFileWriter::AddScalar(const std::string &name, double value)
+{
+    AddColumn(name, RESULTS_F64, &value, 1);
+}
+
+inline void ResultsFileWriter::AddScalar(const std::string &name, uint64_t value)
+{
+    AddColumn(name, RESULTS_U64, &value, 1);
+}
+
+inline bool ResultsFileWriter::Write(const std::string &path) const
+{
+    std::vector<char> file(sizeof(ResultsFileHeader), 0);
+    std::vector<ResultsColumnEntry> index(m_columns.size());
+    for (uint32_t i = 0; i < m_columns.size(); ++i)
+    {
+        file.resize((file.size() + 7) & ~(size_t)7, 0);
+        ResultsColumnEntry &entry = index[i];
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, m_columns[i].name.c_str(), m_columns[i].name.size());
+        entry.type = m_columns[i].type;
+        entry.offset = file.size();
+        entry.count = m_columns[i].count;
+        file.insert(file.end(), m_columns[i].bytes.begin(), m_columns[i].bytes.end());
+    }
+    file.resize((file.size() + 7) & ~(size_t)7, 0);
+
+    ResultsFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_resultsMagic, sizeof(header.magic));
+    header.version = RESULTS_VERSION;
+    header.byteOrder = RESULTS_BYTE_ORDER;
+    header.columnCount = index.size();
+    header.indexOffset = file.size();
+    header.fileSize = file.size() + index.size() * sizeof(ResultsColumnEntry);
+    memcpy(&file[0], &header, sizeof(header));
+    if (!index.empty())
+    {
+        const char *bytes = (const char *)&index[0];
+        file.insert(file.end(), bytes, bytes + index.size() * sizeof(ResultsColumnEntry));
+    }
+
+    std::string tmp = path + ".tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    size_t written = 0;
+    while (written < file.size())
+    {
+        ssize_t n = write(fd, &file[written], file.size() - written);
+        if (n <= 0)
+        {
+            close(fd);
+            unlink(tmp.c_str());
+            return false;
+        }
+        written += n;
+    }
+    if (close(fd) != 0 || rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+class ResultsFileReader {
+public:
+    ResultsFileReader();
+    ~ResultsFileReader();
+
+    bool Open(const std::string &path, std::string &error);
+    void Close();
+    uint32_t ColumnCount() const;
+    const ResultsColumnEntry &Column(uint32_t i) const;
+    const ResultsColumnEntry *Find(const char *name) const;
+    // 列不存在或类型不符时返回 0
+    const void *Data(const char *name, ResultsColumnType type, uint64_t &count) const;
+    const void *Data(const ResultsColumnEntry &entry) const;
+
+private:
+    ResultsFileReader(const ResultsFileReader &);
+    ResultsFileReader &operator=(const ResultsFileReader &);
+
+    const char *m_base;
+    size_t m_size;
+    const ResultsFileHeader *m_header;
+    const ResultsColumnEntry *m_index;
+};
+
+inline ResultsFileReader::ResultsFileReader()
+    : m_base(0),
+      m_size(0),
+      m_header(0),
+      m_index(0)
+{
+}
+
+inline ResultsFileReader::~ResultsFileReader()
+{
+    Close();
+}
+
+inline bool ResultsFileReader::Open(const std::string &path, std::string &error)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ResultsFileHeader))
+    {
+        close(fd);
+        error = path + ": too short";
+        return false;
+    }
+    void *base = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        error = "cannot map " + path;
+        return false;
+    }
+    m_base = (const char *)base;
+    m_size = st.st_size;
+    m_header = (const ResultsFileHeader *)m_base;
+
+    if (memcmp(m_header->magic, g_resultsMagic, sizeof(g_resultsMagic)) != 0)
+    {
+        error = path + ": not a results file";
+    }
+    else if (m_header->byteOrder != RESULTS_BYTE_ORDER || m_header->version != RESULTS_VERSION)
+    {
+        error = path + ": unsupported version or byte order";
+    }
+    else if (m_header->fileSize != m_size || m_header->indexOffset > m_size
+             || (m_size - m_header->indexOffset) / sizeof(ResultsColumnEntry) < m_header->columnCount)
+    {
+        error = path + ": truncated";
+    }
+    else
+    {
+        m_index = (const ResultsColumnEntry *)(m_base + m_header->indexOffset);
+        for (uint32_t i = 0; i < m_header->columnCount; ++i)
+        {
+            uint64_t bytes = m_index[i].count * ResultsTypeSize(m_index[i].type);
+            if (ResultsTypeSize(m_index[i].type) == 0 || m_index[i].offset > m_size || bytes > m_size - m_index[i].offset
+                || m_index[i].name[sizeof(m_index[i].name) - 1] != '\0')
+            {
+                error = path + ": corrupt column index";
+                Close();
+                return false;
+            }
+        }
+        return true;
+    }
+    Close();
+    return false;
+}
+
+inline void ResultsFileReader::Close()
+{
+    if (m_base)
+    {
+        munmap((void *)m_base, m_size);
+    }
+    m_base = 0;
+    m_size = 0;
+    m_header = 0;
+    m_index = 0;
+}
+
+inline uint32_t ResultsFileReader::ColumnCount() const
+{
+    return m_index ? m_header->columnCount : 0;
+}
+
+inline const ResultsColumnEntry &ResultsFileReader::Column(uint32_t i) const
+{
+    return m_index[i];
+}
+
+inline const ResultsColumnEntry *ResultsFileReader::Find(const char *name) const
+{
+    for (uint32_t i = 0; i < ColumnCount(); ++i)
+    {
+        if (strcmp(m_index[i].name, name) == 0)
+        {
+            return &m_index[i];
+        }
+    }
+    return 0;
+}
+
+inline const void *ResultsFileReader::Data(const char *name, ResultsColumnType type, uint64_t &count) const
+{
+    const ResultsColumnEntry *entry = Find(name);
+    if (entry == 0 || entry->type != (uint32_t)type)
+    {
+        count = 0;
+        return 0;
+    }
+    count = entry->count;
+    return Data(*entry);
+}
+
+inline const void *ResultsFileReader::Data(const ResultsColumnEntry &entry) const
+{
+    return m_base + entry.offset;
+}
+
+#endif // RESULTS_FILE_H
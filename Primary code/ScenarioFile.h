@@ -0,0 +1,687 @@
+#ifndef SCENARIO_FILE_H
+#define SCENARIO_FILE_H
+
+// 场景参数、校验和场景文件解析，不依赖 ns-3：仿真程序、参数扫描和独立的检查程序共用
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const uint32_t AUTO_NODE = 0xffffffff;
+
+// 灰洞的实现层次
+enum GreyholeMode {
+    GREYHOLE_APP = 0, // 应用层套接字，只处理发给灰洞节点的数据包
+    GREYHOLE_MAC = 1  // Wi-Fi MAC 发送路径，丢弃途经的数据帧
+};
+
+enum RoutingProtocol {
+    ROUTING_STATIC = 0, // 默认的静态路由，所有节点同一子网、单跳可达
+    ROUTING_AODV = 1    // AODV 按需路由，配合 radioRange 构造多跳拓扑
+};
+
+// 场景参数。角色节点为 AUTO_NODE 时默认 N-3 为源端，N-2 为灰洞，N-1 为目的端，
+// 看门狗列表为空时其余节点都是看门狗
+struct ScenarioConfig {
+    ScenarioConfig();
+
+    uint32_t SourceNode() const;
+    uint32_t GreyholeNode() const;
+    uint32_t SinkNode() const;
+    std::vector<uint32_t> WatchdogNodes() const;
+    uint32_t GridWidth() const;
+    double AreaWidth() const;
+    double AreaHeight() const;
+
+    uint32_t nNodes;
+    uint32_t sourceNode;
+    uint32_t greyholeNode;
+    uint32_t sinkNode;
+    std::vector<uint32_t> watchdogs;
+    double dropProbability;
+    uint32_t greyholeMode; // GreyholeMode
+    uint32_t routing;      // RoutingProtocol
+    double gamma;
+    double threshold;
+    double monitorInterval;
+    uint32_t maxMonitorCount;
+    double neighborRange; // 判定时灰洞不在此距离内即记为误报
+    double radioRange;    // 大于 0 时超出此距离收不到信号，配合 routing = AODV 走多跳路由
+    double gridSpacing;
+    uint32_t gridWidth;   // 0 表示按节点数自动选择
+    double areaWidth;     // 随机游走边界，0 表示自动
+    double areaHeight;
+    double speed;         // 小于 0 时使用 RandomWalk2d 默认速度
+    uint32_t packetSize;
+    double packetInterval;
+    uint32_t maxPackets;
+    double trafficStart;
+    double stopTime;
+    double backgroundLoad;   // 流体背景流量的平均信道占用率，0 表示关闭
+    double backgroundSpread; // 各区域占用率的相对波动
+    double backgroundCell;   // 区域边长，米
+    double churnRate;          // 看门狗随机离开的次数，每秒（全网），0 表示关闭
+    double churnCrashFraction; // 其中崩溃所占比例，其余为正常离开
+    double churnDowntime;      // 离开后重新加入前的平均时长，秒
+};
+
+inline ScenarioConfig::ScenarioConfig()
+    : nNodes(27),
+      sourceNode(AUTO_NODE),
+      greyholeNode(AUTO_NODE),
+      sinkNode(AUTO_NODE),
+      dropProbability(0.05),
+      greyholeMode(GREYHOLE_APP),
+      routing(ROUTING_STATIC),
+      gamma(0.5),
+      threshold(1.0),
+      monitorInterval(1.0),
+      maxMonitorCount(10),
+      neighborRange(50.0),
+      radioRange(0.0),
+      gridSpacing(5.0),
+      gridWidth(0),
+      areaWidth(0.0),
+      areaHeight(0.0),
+      speed(-1.0),
+      packetSize(1024),
+      packetInterval(0.01),
+      maxPackets(1000),
+      trafficStart(2.0),
+      stopTime(30.0),
+      backgroundLoad(0.0),
+      backgroundSpread(0.0),
+      backgroundCell(50.0),
+      churnRate(0.0),
+      churnCrashFraction(0.0),
+      churnDowntime(10.0)
+{
+}
+
+inline uint32_t ScenarioConfig::SourceNode() const
+{
+    return sourceNode == AUTO_NODE ? nNodes - 3 : sourceNode;
+}
+
+inline uint32_t ScenarioConfig::GreyholeNode() const
+{
+    return greyholeNode == AUTO_NODE ? nNodes - 2 : greyholeNode;
+}
+
+inline uint32_t ScenarioConfig::SinkNode() const
+{
+    return sinkNode == AUTO_NODE ? nNodes - 1 : sinkNode;
+}
+
+inline std::vector<uint32_t> ScenarioConfig::WatchdogNodes() const
+{
+    if (!watchdogs.empty())
+    {
+        return watchdogs;
+    }
+    std::vector<uint32_t> ids;
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        if (i != SourceNode() && i != GreyholeNode() && i != SinkNode())
+        {
+            ids.push_back(i);
+        }
+    }
+    return ids;
+}
+
+// 节点较多时放宽网格宽度和活动区域，27 个节点时与原布局一致
+inline uint32_t ScenarioConfig::GridWidth() const
+{
+    return gridWidth > 0 ? gridWidth : std::max<uint32_t>(7, (uint32_t)std::ceil(std::sqrt((double)nNodes)));
+}
+
+inline double ScenarioConfig::AreaWidth() const
+{
+    return areaWidth > 0 ? areaWidth : std::max(105.0, gridSpacing * GridWidth());
+}
+
+inline double ScenarioConfig::AreaHeight() const
+{
+    return areaHeight > 0 ? areaHeight : std::max(105.0, gridSpacing * GridWidth());
+}
+
+inline bool ValidateScenario(const ScenarioConfig &config, std::string &error)
+{
+    std::ostringstream os;
+    uint32_t rows = config.nNodes == 0 ? 0 : (config.nNodes + config.GridWidth() - 1) / config.GridWidth();
+    if (config.nNodes < 4)
+    {
+        os << "nNodes must be at least 4";
+    }
+    else if (config.SourceNode() >= config.nNodes || config.GreyholeNode() >= config.nNodes
+             || config.SinkNode() >= config.nNodes)
+    {
+        os << "source, greyhole and sink must be below nNodes";
+    }
+    else if (config.SourceNode() == config.GreyholeNode() || config.SourceNode() == config.SinkNode()
+             || config.GreyholeNode() == config.SinkNode())
+    {
+        os << "source, greyhole and sink must be distinct nodes";
+    }
+    else if (config.dropProbability < 0 || config.dropProbability > 1)
+    {
+        os << "dropProbability must be in [0, 1]";
+    }
+    else if (config.greyholeMode != GREYHOLE_APP && config.greyholeMode != GREYHOLE_MAC)
+    {
+        os << "greyholeMode must be 0 (application) or 1 (MAC)";
+    }
+    else if (config.routing != ROUTING_STATIC && config.routing != ROUTING_AODV)
+    {
+        os << "routing must be 0 (static) or 1 (AODV)";
+    }
+    else if (config.backgroundLoad < 0 || config.backgroundLoad > 0.95 || config.backgroundSpread < 0
+             || config.backgroundSpread > 1 || config.backgroundCell <= 0)
+    {
+        os << "backgroundLoad must be in [0, 0.95], backgroundSpread in [0, 1] and backgroundCell positive";
+    }
+    else if (config.churnRate < 0 || config.churnCrashFraction < 0 || config.churnCrashFraction > 1
+             || config.churnDowntime <= 0)
+    {
+        os << "churnRate must be non-negative, churnCrashFraction in [0, 1] and churnDowntime positive";
+    }
+    else if (config.radioRange < 0)
+    {
+        os << "radioRange must not be negative";
+    }
+    else if (config.monitorInterval <= 0 || config.packetInterval <= 0 || config.gridSpacing <= 0)
+    {
+        os << "monitorInterval, packetInterval and gridSpacing must be positive";
+    }
+    else if (config.gridSpacing * (config.GridWidth() - 1) > config.AreaWidth()
+             || config.gridSpacing * (rows - 1) > config.AreaHeight())
+    {
+        os << "initial grid does not fit inside the mobility bounds";
+    }
+    else if (config.stopTime <= config.trafficStart || config.trafficStart < 0)
+    {
+        os << "stopTime must be after trafficStart";
+    }
+    else
+    {
+        std::vector<uint32_t> watchdogs = config.WatchdogNodes();
+        for (uint32_t i = 0; i < watchdogs.size(); ++i)
+        {
+            if (watchdogs[i] >= config.nNodes || watchdogs[i] == config.GreyholeNode()
+                || watchdogs[i] == config.SourceNode() || watchdogs[i] == config.SinkNode())
+            {
+                os << "watchdog " << watchdogs[i] << " is out of range or the source, greyhole or sink";
+                break;
+            }
+        }
+        if (watchdogs.empty())
+        {
+            os << "no watchdog nodes";
+        }
+    }
+    error = os.str();
+    return error.empty();
+}
+
+// 可扫描参数表，命令行、参数扫描、场景文件和结果存储共用
+struct ScenarioParam {
+    const char *name;
+    double ScenarioConfig::*real;
+    uint32_t ScenarioConfig::*integer;
+    const char *help;
+};
+
+static const ScenarioParam g_scenarioParams[] = {
+    { "nNodes", 0, &ScenarioConfig::nNodes, "Total number of nodes (watchdogs + source + greyhole + sink)" },
+    { "sourceNode", 0, &ScenarioConfig::sourceNode, "Source node id (4294967295 = nNodes-3)" },
+    { "greyholeNode", 0, &ScenarioConfig::greyholeNode, "Greyhole node id (4294967295 = nNodes-2)" },
+    { "sinkNode", 0, &ScenarioConfig::sinkNode, "Sink node id (4294967295 = nNodes-1)" },
+    { "dropProbability", &ScenarioConfig::dropProbability, 0, "Greyhole drop probability" },
+    { "greyholeMode", 0, &ScenarioConfig::greyholeMode, "Greyhole layer: 0 = application socket, 1 = Wi-Fi MAC transmit path" },
+    { "routing", 0, &ScenarioConfig::routing, "Routing: 0 = static (single hop), 1 = AODV" },
+    { "gamma", &ScenarioConfig::gamma, 0, "Watchdog gamma (not used by the detector kernel)" },
+    { "threshold", &ScenarioConfig::threshold, 0, "Watchdog reputation threshold" },
+    { "monitorInterval", &ScenarioConfig::monitorInterval, 0, "Seconds between watchdog observations" },
+    { "maxMonitorCount", 0, &ScenarioConfig::maxMonitorCount, "Observations per watchdog" },
+    { "neighborRange", &ScenarioConfig::neighborRange, 0, "NEGATIVE verdicts farther than this from the greyhole are false positives" },
+    { "radioRange", &ScenarioConfig::radioRange, 0, "Reception cut-off in metres for multi-hop topologies (0 = propagation loss only)" },
+    { "gridSpacing", &ScenarioConfig::gridSpacing, 0, "Initial grid spacing in metres" },
+    { "gridWidth", 0, &ScenarioConfig::gridWidth, "Nodes per grid row (0 = automatic)" },
+    { "areaWidth", &ScenarioConfig::areaWidth, 0, "Random walk bound in x (0 = automatic)" },
+    { "areaHeight", &ScenarioConfig::areaHeight, 0, "Random walk bound in y (0 = automatic)" },
+    { "speed", &ScenarioConfig::speed, 0, "Random walk speed in m/s (negative keeps the model default)" },
+    { "packetSize", 0, &ScenarioConfig::packetSize, "Echo payload size in bytes" },
+    { "packetInterval", &ScenarioConfig::packetInterval, 0, "Seconds between echo requests" },
+    { "maxPackets", 0, &ScenarioConfig::maxPackets, "Echo requests sent by the source" },
+    { "trafficStart", &ScenarioConfig::trafficStart, 0, "Time the source starts sending" },
+    { "stopTime", &ScenarioConfig::stopTime, 0, "Simulation stop time in seconds" },
+    { "backgroundLoad", &ScenarioConfig::backgroundLoad, 0, "Mean channel occupancy of fluid background traffic (0 = off)" },
+    { "backgroundSpread", &ScenarioConfig::backgroundSpread, 0, "Relative variation of background occupancy between regions" },
+    { "backgroundCell", &ScenarioConfig::backgroundCell, 0, "Side of a background traffic region in metres" },
+    { "churnRate", &ScenarioConfig::churnRate, 0, "Random watchdog departures per second across the network (0 = off)" },
+    { "churnCrashFraction", &ScenarioConfig::churnCrashFraction, 0, "Fraction of random departures that are crashes" },
+    { "churnDowntime", &ScenarioConfig::churnDowntime, 0, "Mean seconds a departed watchdog stays away" },
+};
+
+inline const ScenarioParam *FindScenarioParam(const std::string &name)
+{
+    for (uint32_t i = 0; i < sizeof(g_scenarioParams) / sizeof(g_scenarioParams[0]); ++i)
+    {
+        if (name == g_scenarioParams[i].name)
+        {
+            return &g_scenarioParams[i];
+        }
+    }
+    return 0;
+}
+
+inline bool SetScenarioParam(ScenarioConfig &config, const std::string &name, double value)
+{
+    const ScenarioParam *param = FindScenarioParam(name);
+    if (param == 0)
+    {
+        return false;
+    }
+    if (param->integer)
+    {
+        config.*(param->integer) = (uint32_t)std::floor(value + 0.5);
+    }
+    else
+    {
+        config.*(param->real) = value;
+    }
+    return true;
+}
+
+inline std::string FormatScenarioParam(const ScenarioConfig &config, const ScenarioParam &param)
+{
+    char buf[64];
+    if (param.integer)
+    {
+        snprintf(buf, sizeof(buf), "%u", config.*(param.integer));
+    }
+    else
+    {
+        snprintf(buf, sizeof(buf), "%.17g", config.*(param.real));
+    }
+    return buf;
+}
+
+inline std::string FormatNodeList(const std::vector<uint32_t> &ids)
+{
+    std::ostringstream os;
+    for (uint32_t i = 0; i < ids.size(); ++i)
+    {
+        os << (i > 0 ? "," : "") << ids[i];
+    }
+    return os.str();
+}
+
+inline bool ParseNodeList(const std::string &text, std::vector<uint32_t> &ids)
+{
+    ids.clear();
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        char *end;
+        unsigned long id = strtoul(item.c_str(), &end, 10);
+        if (end == item.c_str() || *end != '\0')
+        {
+            return false;
+        }
+        ids.push_back((uint32_t)id);
+    }
+    return true;
+}
+
+// 规范化的参数串，用作结果存储的键
+inline std::string FormatScenarioConfig(const ScenarioConfig &config)
+{
+    std::string s;
+    for (uint32_t i = 0; i < sizeof(g_scenarioParams) / sizeof(g_scenarioParams[0]); ++i)
+    {
+        if (i > 0)
+        {
+            s += ";";
+        }
+        s += g_scenarioParams[i].name;
+        s += "=";
+        s += FormatScenarioParam(config, g_scenarioParams[i]);
+    }
+    if (!config.watchdogs.empty())
+    {
+        s += ";watchdogs=" + FormatNodeList(config.watchdogs);
+    }
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// 场景文件：TOML 风格，一个文件可包含数百个场景，一次读入内存后单遍解析
+//
+//   # 注释
+//   [defaults]              # 之后的键作用于后续所有场景；文件开头、首个段之前的键同样如此
+//   nNodes = 27
+//   stopTime = 30
+//
+//   [[scenario]]            # 新场景，从当前 defaults 复制
+//   name = "high-drop"
+//   dropProbability = 0.5
+//   greyholeNode = 12
+//   watchdogs = [0, 1, 2, 3]
+//   run = 2
+//
+// 键为 g_scenarioParams 中的参数名以及 name、watchdogs、run；每个场景结束时做一次完整校验
+
+struct ScenarioEntry {
+    std::string name;
+    ScenarioConfig config;
+    uint32_t run;
+};
+
+class ScenarioFileParser {
+public:
+    ScenarioFileParser(const std::string &path, const ScenarioConfig &defaults, uint32_t defaultRun);
+
+    bool Parse(std::vector<ScenarioEntry> &entries);
+
+private:
+    bool Fail(const std::string &message);
+    void SkipBlanks();
+    bool AtLineEnd() const;
+    void NextLine();
+    bool Consume(const char *token);
+    bool ParseKey(std::string &key);
+    bool ParseNumber(double &value);
+    bool ParseString(std::string &value);
+    bool ParseNodeArray(std::vector<uint32_t> &ids);
+    bool ParseAssignment(ScenarioEntry &entry, bool inScenario);
+    bool FinishScenario(const ScenarioEntry &entry);
+
+    std::string m_path;
+    std::string m_text;
+    const char *m_pos;
+    const char *m_end;
+    uint32_t m_line;
+    uint32_t m_scenarioLine;
+    ScenarioEntry m_defaults;
+};
+
+inline ScenarioFileParser::ScenarioFileParser(const std::string &path, const ScenarioConfig &defaults, uint32_t defaultRun)
+    : m_path(path),
+      m_pos(0),
+      m_end(0),
+      m_line(1),
+      m_scenarioLine(0)
+{
+    m_defaults.config = defaults;
+    m_defaults.run = defaultRun;
+}
+
+inline bool ScenarioFileParser::Fail(const std::string &message)
+{
+    std::clog << m_path << ":" << m_line << ": " << message << std::endl;
+    return false;
+}
+
+inline void ScenarioFileParser::SkipBlanks()
+{
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t'))
+    {
+        m_pos++;
+    }
+}
+
+inline bool ScenarioFileParser::AtLineEnd() const
+{
+    return m_pos == m_end || *m_pos == '#' || *m_pos == '\r' || *m_pos == '\n';
+}
+
+inline void ScenarioFileParser::NextLine()
+{
+    while (m_pos < m_end && *m_pos != '\n')
+    {
+        m_pos++;
+    }
+    if (m_pos < m_end)
+    {
+        m_pos++;
+        m_line++;
+    }
+}
+
+inline bool ScenarioFileParser::Consume(const char *token)
+{
+    size_t n = strlen(token);
+    if ((size_t)(m_end - m_pos) >= n && memcmp(m_pos, token, n) == 0)
+    {
+        m_pos += n;
+        return true;
+    }
+    return false;
+}
+
+inline bool ScenarioFileParser::ParseKey(std::string &key)
+{
+    const char *start = m_pos;
+    while (m_pos < m_end && (isalnum((unsigned char)*m_pos) || *m_pos == '_'))
+    {
+        m_pos++;
+    }
+    key.assign(start, m_pos);
+    return !key.empty() || Fail("expected a key");
+}
+
+inline bool ScenarioFileParser::ParseNumber(double &value)
+{
+    char *end;
+    value = strtod(m_pos, &end); // m_text 以 NUL 结尾
+    if (end == m_pos || end > m_end)
+    {
+        return Fail("expected a number");
+    }
+    m_pos = end;
+    return true;
+}
+
+inline bool ScenarioFileParser::ParseString(std::string &value)
+{
+    if (!Consume("\""))
+    {
+        return Fail("expected a quoted string");
+    }
+    const char *start = m_pos;
+    while (m_pos < m_end && *m_pos != '"' && *m_pos != '\n')
+    {
+        m_pos++;
+    }
+    if (m_pos == m_end || *m_pos != '"')
+    {
+        return Fail("unterminated string");
+    }
+    value.assign(start, m_pos);
+    m_pos++;
+    return true;
+}
+
+inline bool ScenarioFileParser::ParseNodeArray(std::vector<uint32_t> &ids)
+{
+    ids.clear();
+    if (!Consume("["))
+    {
+        return Fail("expected '['");
+    }
+    SkipBlanks();
+    if (Consume("]"))
+    {
+        return true;
+    }
+    for (;;)
+    {
+        double id;
+        SkipBlanks();
+        if (!ParseNumber(id))
+        {
+            return false;
+        }
+        if (id < 0 || id != std::floor(id))
+        {
+            return Fail("node ids must be non-negative integers");
+        }
+        ids.push_back((uint32_t)id);
+        SkipBlanks();
+        if (Consume("]"))
+        {
+            return true;
+        }
+        if (!Consume(","))
+        {
+            return Fail("expected ',' or ']'");
+        }
+    }
+}
+
+inline bool ScenarioFileParser::ParseAssignment(ScenarioEntry &entry, bool inScenario)
+{
+    std::string key;
+    if (!ParseKey(key))
+    {
+        return false;
+    }
+    SkipBlanks();
+    if (!Consume("="))
+    {
+        return Fail("expected '=' after " + key);
+    }
+    SkipBlanks();
+    if (key == "name")
+    {
+        if (!inScenario)
+        {
+            return Fail("name is only valid inside [[scenario]]");
+        }
+        return ParseString(entry.name);
+    }
+    if (key == "watchdogs")
+    {
+        return ParseNodeArray(entry.config.watchdogs);
+    }
+    double value;
+    if (key == "run")
+    {
+        if (!ParseNumber(value))
+        {
+            return false;
+        }
+        entry.run = (uint32_t)value;
+        return true;
+    }
+    const ScenarioParam *param = FindScenarioParam(key);
+    if (param == 0)
+    {
+        return Fail("unknown key " + key);
+    }
+    if (!ParseNumber(value))
+    {
+        return false;
+    }
+    if (param->integer && (value < 0 || value > 4294967295.0))
+    {
+        return Fail(key + " must be a non-negative integer");
+    }
+    SetScenarioParam(entry.config, key, value);
+    return true;
+}
+
+inline bool ScenarioFileParser::FinishScenario(const ScenarioEntry &entry)
+{
+    std::string error;
+    if (!ValidateScenario(entry.config, error))
+    {
+        std::clog << m_path << ":" << m_scenarioLine << ": scenario " << entry.name << ": " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+inline bool ScenarioFileParser::Parse(std::vector<ScenarioEntry> &entries)
+{
+    std::ifstream in(m_path.c_str(), std::ios::binary);
+    if (!in)
+    {
+        std::clog << "Cannot open scenario file " << m_path << std::endl;
+        return false;
+    }
+    m_text.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    m_pos = m_text.c_str();
+    m_end = m_pos + m_text.size();
+    m_line = 1;
+
+    bool inScenario = false;
+    while (m_pos < m_end)
+    {
+        SkipBlanks();
+        if (AtLineEnd())
+        {
+            NextLine();
+            continue;
+        }
+        if (*m_pos == '[')
+        {
+            if (inScenario && !FinishScenario(entries.back()))
+            {
+                return false;
+            }
+            if (Consume("[[scenario]]"))
+            {
+                inScenario = true;
+                m_scenarioLine = m_line;
+                entries.push_back(m_defaults);
+                std::ostringstream name;
+                name << "scenario" << entries.size();
+                entries.back().name = name.str();
+            }
+            else if (Consume("[defaults]"))
+            {
+                inScenario = false;
+            }
+            else
+            {
+                return Fail("unknown section");
+            }
+        }
+        else if (!ParseAssignment(inScenario ? entries.back() : m_defaults, inScenario))
+        {
+            return false;
+        }
+        SkipBlanks();
+        if (!AtLineEnd())
+        {
+            return Fail("unexpected characters at end of line");
+        }
+        NextLine();
+    }
+    if (inScenario && !FinishScenario(entries.back()))
+    {
+        return false;
+    }
+    if (entries.empty())
+    {
+        std::clog << m_path << ": no [[scenario]] sections" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#endif // SCENARIO_FILE_H
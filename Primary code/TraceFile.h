@@ -0,0 +1,495 @@
+#ifndef TRACE_FILE_H
+#define TRACE_FILE_H
+
+// 分块、带索引的仿真跟踪文件，不依赖 ns-3：
+//   文件头 | 数据块... | 各块的节点表（uint32，升序）| 块索引
+// 每条记录为 (时间 ns, 节点, 类型, a, b)。块内按时间顺序存放，时间取与上一条记录的差值，
+// 其余字段为 varint（a、b 先做 zigzag）。块索引记录每块的时间范围和出现过的节点，
+// 查询时二分定位时间窗口，只解码包含目标节点的块
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+enum TraceRecordType {
+    TRACE_OBSERVATION = 1,  // a = 观察到的事件，b = 更新后的信誉 ×1000
+    TRACE_VERDICT,          // a = 新判定，b = 信誉 ×1000
+    TRACE_GREYHOLE_DROP,    // a = 数据包 uid，b = 字节数
+    TRACE_GREYHOLE_FORWARD, // a = 数据包 uid，b = 字节数
+    TRACE_POSITION,         // a = x，b = y，单位毫米
+    TRACE_PHY_TX,           // PHY 开始发送，a = 数据包 uid，b = 字节数
+    TRACE_PHY_RX,           // PHY 接收完成，a = 数据包 uid，b = 字节数
+    TRACE_RECORD_TYPE_END
+};
+
+inline const char *TraceRecordTypeName(uint32_t type)
+{
+    static const char *names[TRACE_RECORD_TYPE_END] = {
+        "unknown", "observation", "verdict", "greyhole-drop", "greyhole-forward", "position", "phy-tx", "phy-rx"
+    };
+    return type < TRACE_RECORD_TYPE_END ? names[type] : names[0];
+}
+
+static const char g_traceMagic[8] = { 'G', 'H', 'T', 'R', 'A', 'C', 'E', '1' };
+static const uint32_t TRACE_VERSION = 1;
+static const uint32_t TRACE_BYTE_ORDER = 0x01020304;
+static const uint32_t TRACE_ALL_NODES = 0xffffffff;
+
+struct TraceRecord {
+    int64_t time; // 纳秒
+    uint32_t node;
+    uint32_t type;
+    int64_t a;
+    int64_t b;
+};
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t blockCount;
+    uint64_t recordCount;
+    uint64_t nodesOffset; // 各块节点表拼接成的 uint32 数组
+    uint64_t indexOffset;
+    uint64_t fileSize;    // 为 0 表示写入未正常结束
+};
+
+struct TraceBlockEntry {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t records;
+    int64_t timeMin;
+    int64_t timeMax;
+    uint64_t nodesStart; // 在节点数组中的下标
+    uint32_t nodesCount;
+    uint32_t reserved;
+};
+
+class TraceWriter {
+public:
+    TraceWriter();
+    ~TraceWriter();
+
+    bool Open(const std::string &path, uint32_t blockBytes = 65536);
+    // 时间必须单调不减
+    void Append(int64_t time, uint32_t node, uint32_t type, int64_t a, int64_t b);
+    bool Close();
+    bool IsOpen() const;
+    uint64_t Records() const;
+
+private:
+    TraceWriter(const TraceWriter &);
+    TraceWriter &operator=(const TraceWriter &);
+
+    void PutVarint(uint64_t value);
+    void Flush();
+    bool WriteBytes(const void *data, size_t size);
+
+    FILE *m_file;
+    uint32_t m_blockBytes;
+    std::vector<uint8_t> m_block;
+    std::vector<uint32_t> m_blockNodes;
+    uint32_t m_blockRecords;
+    int64_t m_blockMin;
+    int64_t m_lastTime;
+    std::vector<TraceBlockEntry> m_index;
+    std::vector<uint32_t> m_nodes;
+    uint64_t m_offset;
+    uint64_t m_records;
+    bool m_failed;
+};
+
+inline TraceWriter::TraceWriter()
+    : m_file(0),
+      m_blockBytes(65536),
+      m_blockRecords(0),
+      m_blockMin(0),
+      m_lastTime(0),
+      m_offset(0),
+      m_records(0),
+      m_failed(false)
+{
+}
+
+inline TraceWriter::~TraceWriter()
+{
+    Close();
+}
+
+inline bool TraceWriter::Open(const std::string &path, uint32_t blockBytes)
+{
+    Close();
+    m_file = fopen(path.c_str(), "wb");
+    if (m_file == 0)
+    {
+        return false;
+    }
+    m_blockBytes = blockBytes;
+    m_block.clear();
+    m_block.reserve(blockBytes + 64);
+    m_blockNodes.clear();
+    m_blockRecords = 0;
+    m_index.clear();
+    m_nodes.clear();
+    m_records = 0;
+    m_failed = false;
+    // 文件头在 Close 时重写
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_traceMagic, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.byteOrder = TRACE_BYTE_ORDER;
+    m_offset = 0;
+    return WriteBytes(&header, sizeof(header));
+}
+
+inline bool TraceWriter::IsOpen() const
+{
+    return m_file != 0;
+}
+
+inline uint64_t TraceWriter::Records() const
+{
+    return m_records;
+}
+
+inline void TraceWriter::PutVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_block.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    m_block.push_back((uint8_t)value);
+}
+
+inline void TraceWriter::Append(int64_t time, uint32_t node, uint32_t type, int64_t a, int64_t b)
+{
+    if (m_file == 0)
+    {
+        return;
+    }
+    if (m_blockRecords == 0)
+    {
+        m_blockMin = time;
+        m_lastTime = time;
+    }
+    if (time < m_lastTime)
+    {
+        time = m_lastTime;
+    }
+    PutVarint((uint64_t)(time - m_lastTime));
+    PutVarint(node);
+    PutVarint(type);
+    PutVarint(((uint64_t)a << 1) ^ (uint64_t)(a >> 63));
+    PutVarint(((uint64_t)b << 1) ^ (uint64_t)(b >> 63));
+    m_lastTime = time;
+    m_blockNodes.push_back(node);
+    m_blockRecords++;
+    m_records++;
+    if (m_block.size() >= m_blockBytes)
+    {
+        Flush();
+    }
+}
+
+inline bool TraceWriter::WriteBytes(const void *data, size_t size)
+{
+    if (size > 0 && fwrite(data, 1, size, m_file) != size)
+    {
+        m_failed = true;
+    }
+    m_offset += size;
+    return !m_failed;
+}
+
+inline void TraceWriter::Flush()
+{
+    if (m_blockRecords == 0)
+    {
+        return;
+    }
+    std::sort(m_blockNodes.begin(), m_blockNodes.end());
+    m_blockNodes.erase(std::unique(m_blockNodes.begin(), m_blockNodes.end()), m_blockNodes.end());
+
+    TraceBlockEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = m_offset;
+    entry.size = m_block.size();
+    entry.records = m_blockRecords;
+    entry.timeMin = m_blockMin;
+    entry.timeMax = m_lastTime;
+    entry.nodesStart = m_nodes.size();
+    entry.nodesCount = m_blockNodes.size();
+    m_index.push_back(entry);
+    m_nodes.insert(m_nodes.end(), m_blockNodes.begin(), m_blockNodes.end());
+
+    WriteBytes(&m_block[0], m_block.size());
+    m_block.clear();
+    m_blockNodes.clear();
+    m_blockRecords = 0;
+}
+
+inline bool TraceWriter::Close()
+{
+    if (m_file == 0)
+    {
+        return true;
+    }
+    Flush();
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_traceMagic, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.byteOrder = TRACE_BYTE_ORDER;
+    header.blockCount = m_index.size();
+    header.recordCount = m_records;
+    header.nodesOffset = m_offset;
+    WriteBytes(m_nodes.empty() ? 0 : &m_nodes[0], m_nodes.size() * sizeof(uint32_t));
+    static const char padding[8] = { 0 };
+    WriteBytes(padding, (8 - m_offset % 8) % 8);
+    header.indexOffset = m_offset;
+    WriteBytes(m_index.empty() ? 0 : &m_index[0], m_index.size() * sizeof(TraceBlockEntry));
+    header.fileSize = m_offset;
+    if (fseek(m_file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, m_file) != 1)
+    {
+        m_failed = true;
+    }
+    if (fclose(m_file) != 0)
+    {
+        m_failed = true;
+    }
+    m_file = 0;
+    return !m_failed;
+}
+
+class TraceReader {
+public:
+    TraceReader();
+    ~TraceReader();
+
+    bool Open(const std::string &path, std::string &error);
+    void Close();
+    uint64_t Blocks() const;
+    uint64_t Records() const;
+    const TraceBlockEntry &Block(uint64_t i) const;
+    bool BlockHasNode(uint64_t i, uint32_t node) const;
+    // 追加解码第 i 块的全部记录
+    bool DecodeBlock(uint64_t i, std::vector<TraceRecord> &records) const;
+    // 对 [from, to] 内属于 node 的每条记录调用 visit；返回解码过的块数
+    template <typename Visitor>
+    uint64_t Query(uint32_t node, int64_t from, int64_t to, Visitor visit) const;
+
+private:
+    TraceReader(const TraceReader &);
+    TraceReader &operator=(const TraceReader &);
+
+    const uint8_t *m_base;
+    size_t m_size;
+    const TraceFileHeader *m_header;
+    const TraceBlockEntry *m_index;
+    const uint32_t *m_nodes;
+};
+
+inline TraceReader::TraceReader()
+    : m_base(0),
+      m_size(0),
+      m_header(0),
+      m_index(0),
+      m_nodes(0)
+{
+}
+
+inline TraceReader::~TraceReader()
+{
+    Close();
+}
+
+inline bool TraceReader::Open(const std::string &path, std::string &error)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TraceFileHeader))
+    {
+        close(fd);
+        error = path + ": too short";
+        return false;
+    }
+    void *base = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        error = "cannot map " + path;
+        return false;
+    }
+    m_base = (const uint8_t *)base;
+    m_size = st.st_size;
+    m_header = (const TraceFileHeader *)m_base;
+
+    const TraceFileHeader &h = *m_header;
+    if (memcmp(h.magic, g_traceMagic, sizeof(g_traceMagic)) != 0)
+    {
+        error = path + ": not a trace file";
+    }
+    else if (h.byteOrder != TRACE_BYTE_ORDER || h.version != TRACE_VERSION)
+    {
+        error = path + ": unsupported version or byte order";
+    }
+    else if (h.fileSize != m_size || h.indexOffset > m_size || h.nodesOffset > h.indexOffset
+             || (m_size - h.indexOffset) / sizeof(TraceBlockEntry) < h.blockCount)
+    {
+        error = path + ": incomplete or truncated trace";
+    }
+    else
+    {
+        m_index = (const TraceBlockEntry *)(m_base + h.indexOffset);
+        m_nodes = (const uint32_t *)(m_base + h.nodesOffset);
+        uint64_t nodesCount = (h.indexOffset - h.nodesOffset) / sizeof(uint32_t);
+        for (uint64_t i = 0; i < h.blockCount; ++i)
+        {
+            const TraceBlockEntry &b = m_index[i];
+            if (b.offset > h.nodesOffset || b.size > h.nodesOffset - b.offset
+                || b.nodesStart > nodesCount || b.nodesCount > nodesCount - b.nodesStart)
+            {
+                error = path + ": corrupt block index";
+                Close();
+                return false;
+            }
+        }
+        return true;
+    }
+    Close();
+    return false;
+}
+
+inline void TraceReader::Close()
+{
+    if (m_base)
+    {
+        munmap((void *)m_base, m_size);
+    }
+    m_base = 0;
+    m_size = 0;
+    m_header = 0;
+    m_index = 0;
+    m_nodes = 0;
+}
+
+inline uint64_t TraceReader::Blocks() const
+{
+    return m_index ? m_header->blockCount : 0;
+}
+
+inline uint64_t TraceReader::Records() const
+{
+    return m_index ? m_header->recordCount : 0;
+}
+
+inline const TraceBlockEntry &TraceReader::Block(uint64_t i) const
+{
+    return m_index[i];
+}
+
+inline bool TraceReader::BlockHasNode(uint64_t i, uint32_t node) const
+{
+    const uint32_t *begin = m_nodes + m_index[i].nodesStart;
+    const uint32_t *end = begin + m_index[i].nodesCount;
+    return std::binary_search(begin, end, node);
+}
+
+inline bool TraceReader::DecodeBlock(uint64_t i, std::vector<TraceRecord> &records) const
+{
+    const TraceBlockEntry &block = m_index[i];
+    const uint8_t *p = m_base + block.offset;
+    const uint8_t *end = p + block.size;
+    int64_t time = block.timeMin;
+    for (uint32_t r = 0; r < block.records; ++r)
+    {
+        uint64_t fields[5];
+        for (uint32_t f = 0; f < 5; ++f)
+        {
+            uint64_t value = 0;
+            uint32_t shift = 0;
+            for (;;)
+            {
+                if (p == end || shift > 63)
+                {
+                    return false;
+                }
+                uint8_t byte = *p++;
+                value |= (uint64_t)(byte & 0x7f) << shift;
+                if (byte < 0x80)
+                {
+                    break;
+                }
+                shift += 7;
+            }
+            fields[f] = value;
+        }
+        time += (int64_t)fields[0];
+        TraceRecord record;
+        record.time = time;
+        record.node = (uint32_t)fields[1];
+        record.type = (uint32_t)fields[2];
+        record.a = (int64_t)(fields[3] >> 1) ^ -(int64_t)(fields[3] & 1);
+        record.b = (int64_t)(fields[4] >> 1) ^ -(int64_t)(fields[4] & 1);
+        records.push_back(record);
+    }
+    return true;
+}
+
+template <typename Visitor>
+uint64_t TraceReader::Query(uint32_t node, int64_t from, int64_t to, Visitor visit) const
+{
+    // 块按时间顺序写入：二分找到第一个 timeMax >= from 的块
+    uint64_t lo = 0;
+    uint64_t hi = Blocks();
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (m_index[mid].timeMax < from)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    uint64_t decoded = 0;
+    std::vector<TraceRecord> records;
+    for (uint64_t i = lo; i < Blocks() && m_index[i].timeMin <= to; ++i)
+    {
+        if (node != TRACE_ALL_NODES && !BlockHasNode(i, node))
+        {
+            continue;
+        }
+        records.clear();
+        DecodeBlock(i, records);
+        decoded++;
+        for (uint32_t r = 0; r < records.size(); ++r)
+        {
+            const TraceRecord &record = records[r];
+            if (record.time >= from && record.time <= to && (node == TRACE_ALL_NODES || record.node == node))
+            {
+                visit(record);
+            }
+        }
+    }
+    return decoded;
+}
+
+#endif // TRACE_FILE_H